@@ -3,6 +3,7 @@
 #include <util/delay.h>
 #include <avr/interrupt.h>
 #include <avr/sleep.h>
+#include <util/atomic.h>
 
 // Button-Pin-Definitionen (an PORTD)
 #define BUTTON_BRIGHTNESS PD0  // PD0: Wird nun nur als Wakeup genutzt,
@@ -25,8 +26,29 @@ void disable_unused_peripherals(void) {
     ACSR |= (1 << ACD); //ACD
 }
 
-// Timeout für die Anzeige (in Sekunden); wird bei manueller Eingabe auf 10 gesetzt.
-volatile uint8_t display_timeout = 10;
+// ----------------- Weck-Geste -----------------
+// Einfacher Druck: Uhrzeit nur kurz anzeigen ("Glance") und schnell ausblenden.
+// Doppelter Druck: volle Anzeige (10 s) mit Zeit- und Helligkeitseinstellung.
+// Alle Zeiten in Timer2-Ticks: 1 Tick = 1/256 s (ca. 3,9 ms), siehe ticks_now().
+#define GLANCE_TICKS        192         // Anzeigedauer bei einfachem Druck: 0,75 s (sinnvoll 26..512 = 0,1..2 s)
+#define GLANCE_FADE_TICKS    32         // Ausblenden nach dem Glance: 125 ms
+#define DOUBLE_PRESS_TICKS  102         // Zweiter Druck muss innerhalb von ca. 0,4 s nach dem ersten kommen
+#define DEBOUNCE_TICKS        5         // ca. 20 ms Entprellung zwischen Loslassen und zweitem Druck
+#define FULL_TIMEOUT_TICKS  (10 * 256)  // Volle Anzeige: 10 s, wird bei jeder Eingabe neu gestartet
+
+#if GLANCE_TICKS < 26 || GLANCE_TICKS > 512
+#error "GLANCE_TICKS muss zwischen 26 (0,1 s) und 512 (2 s) liegen"
+#endif
+#if GLANCE_FADE_TICKS == 0
+#error "GLANCE_FADE_TICKS darf nicht 0 sein"
+#endif
+
+// Sekundenzähler für die Zeitbasis der Anzeige (läuft alle 256 s über, nur für Differenzen benutzt)
+volatile uint8_t uptime_seconds = 0;
+// Anzeige aktiv? Die ISR aktualisiert die LEDs nur, wenn die Anzeige an ist.
+volatile uint8_t display_on = 0;
+// LED-Einschaltdauer des letzten Weckvorgangs in Ticks (zum Auslesen per Debugger)
+volatile uint16_t last_wake_on_ticks = 0;
 
 // ----------------- Helligkeitssteuerung -----------------
 // 5 Helligkeitsstufen für Minuten- und Stunden-LEDs, getrennt konfiguriert
@@ -53,6 +75,12 @@ void set_pwm_hours(uint8_t bright) {
     OCR1B = bright;
 }
 
+// Setzt beide PWM-Kanäle gemäß brightness_index.
+void apply_brightness(void) {
+    set_pwm_minutes(brightness_levels_minutes[brightness_index]);
+    set_pwm_hours(brightness_levels_hours[brightness_index]);
+}
+
 // ----------------- I/O-Initialisierung -----------------
 // - Minuten-LEDs: PORTC (PC0 bis PC5) als Ausgänge
 // - Stunden-LEDs: PORTD (PD3 bis PD7) als Ausgänge
@@ -74,20 +102,34 @@ void update_time_display(void) {
     PORTD = (PORTD & 0x07) | ((hours & 0x1F) << 3);
 }
 
+// Schaltet alle LEDs aus; PD0-PD2 bleiben als Eingänge für die Buttons unverändert.
+void display_off(void) {
+    display_on = 0;
+    PORTC &= ~0x3F;  // Minuten-LEDs aus
+    PORTD &= 0x07;   // Stunden-LEDs aus
+}
+
+// Liefert 1, solange mindestens ein Button (active low) gedrückt ist.
+uint8_t any_button_pressed(void) {
+    return (PIND & ((1 << BUTTON_BRIGHTNESS) | (1 << BUTTON_MINUTES) | (1 << BUTTON_HOURS)))
+           != ((1 << BUTTON_BRIGHTNESS) | (1 << BUTTON_MINUTES) | (1 << BUTTON_HOURS));
+}
+
 // ----------------- Timer2 (Zeitbasis) -----------------
-// Timer2 im asynchronen CTC-Modus mit externem 32,768 kHz-Quarz.
-// Prescaler 128: 32768/128 = 256 Ticks pro Sekunde, OCR2A = 255 ? 1 Sekunde.
+// Timer2 im asynchronen Normal-Modus mit externem 32,768 kHz-Quarz.
+// Prescaler 128: 32768/128 = 256 Ticks pro Sekunde, Überlauf (255 -> 0) = 1 Sekunde.
+// Overflow statt CTC, damit die Sekunde genau dann zählt, wenn TCNT2 auf 0 springt (siehe ticks_now()).
 void init_timer2(void) {
     ASSR |= (1 << AS2);
-    TCCR2A = (1 << WGM21);
+    TCCR2A = 0;
     TCCR2B = (1 << CS22) | (1 << CS20);
-    OCR2A = 255;
-    TIMSK2 |= (1 << OCIE2A);
-    while (ASSR & ((1 << TCR2BUB) | (1 << TCR2AUB) | (1 << OCR2AUB) | (1 << TCN2UB)));
+    TIMSK2 |= (1 << TOIE2);
+    while (ASSR & ((1 << TCR2BUB) | (1 << TCR2AUB) | (1 << TCN2UB)));
 }
 
-// Timer2 Compare Match ISR (wird einmal pro Sekunde aufgerufen)
-ISR(TIMER2_COMPA_vect) {
+// Timer2 Overflow ISR (wird einmal pro Sekunde aufgerufen)
+ISR(TIMER2_OVF_vect) {
+    uptime_seconds++;
     seconds++;
     if (seconds >= 60) {
         seconds = 0;
@@ -96,13 +138,43 @@ ISR(TIMER2_COMPA_vect) {
             minutes = 0;
             hours = (hours + 1) % 24;
         }
-        if(display_timeout > 0) {
+        if(display_on) {
             update_time_display();
         }
     }
-    if(display_timeout > 0) {
-        display_timeout--;
+}
+
+// Aktuelle Zeit in Timer2-Ticks (1/256 s): obere 8 Bit = uptime_seconds, untere 8 Bit = TCNT2.
+// Läuft alle 256 s über; Zeitpunkte daher nur per Differenz vergleichen (siehe tick_reached()).
+uint16_t ticks_now(void) {
+    uint8_t s, t;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        s = uptime_seconds;
+        t = TCNT2;
+        // Überlauf schon erfolgt, ISR aber noch nicht gelaufen? Ein kleines t wurde dann
+        // nach dem Überlauf gelesen und gehört zur nächsten Sekunde.
+        if ((TIFR2 & (1 << TOV2)) && t < 128) {
+            s++;
+        }
     }
+    return ((uint16_t)s << 8) | t;
+}
+
+// Liefert 1, sobald der Zeitpunkt deadline (in Ticks) erreicht oder überschritten ist.
+uint8_t tick_reached(uint16_t deadline) {
+    return (int16_t)(ticks_now() - deadline) >= 0;
+}
+
+// ----------------- Button-Wakeup (Pin Change) -----------------
+// PD0-PD2 lösen PCINT16-18 aus, damit ein Tastendruck den MCU sofort aus dem
+// Power-Save-Modus weckt (sonst erst beim nächsten Timer2-Interrupt, bis zu 1 s später).
+void init_button_wakeup(void) {
+    PCMSK2 |= (1 << PCINT16) | (1 << PCINT17) | (1 << PCINT18);
+    PCICR |= (1 << PCIE2);
+}
+
+// Nur zum Aufwachen; ausgewertet werden die Buttons in main().
+ISR(PCINT2_vect) {
 }
 
 // ----------------- Sleep-Mode -----------------
@@ -113,17 +185,23 @@ ISR(TIMER2_COMPA_vect) {
 // Peripherie wieder reaktiviert.
 void go_to_sleep(void) {
     // LEDs ausschalten:
-    PORTC &= ~0x3F;  // Minuten-LEDs aus
-    PORTD &= 0x07;   // Stunden-LEDs aus (PD0-PD2 bleiben als Eingänge für die Buttons unverändert)
-    
+    display_off();
+
     // Deaktiviere ungenutzte Module (z. B. ADC und Timer0)
     PRR |= (1 << PRADC) | (1 << PRTIM0);
     
     set_sleep_mode(SLEEP_MODE_PWR_SAVE);
-    sleep_enable();
-    sleep_cpu();  // MCU geht schlafen; Timer2 läuft weiterhin
-    sleep_disable();
-    
+    // Tastenprüfung und Einschlafen ohne Lücke: Ein Pin-Change zwischen Prüfung und
+    // sleep_cpu() bleibt bis nach dem sei() anhängig und weckt den MCU sofort wieder.
+    cli();
+    if (!any_button_pressed()) {
+        sleep_enable();
+        sei();
+        sleep_cpu();  // MCU geht schlafen; Timer2 läuft weiterhin
+        sleep_disable();
+    }
+    sei();
+
     // Nach dem Aufwachen: Warte ca. 15ms für die Einschwingzeit des externen Quarzoszillators
     _delay_ms(15);
     
@@ -131,66 +209,148 @@ void go_to_sleep(void) {
     PRR &= ~((1 << PRADC) | (1 << PRTIM0));
 }
 
+// ----------------- Weck-Geste auswerten -----------------
+// PWM-Wert während des Ausblendens: linear von der aktuellen Stufe on
+// (remaining = GLANCE_FADE_TICKS) bis 0 (remaining = 0).
+uint8_t fade_level(uint8_t on, uint16_t remaining) {
+    return ((uint32_t)on * remaining) / GLANCE_FADE_TICKS;
+}
+
+// Wird direkt nach dem Aufwachen aufgerufen, während der erste Tastendruck noch anliegt.
+// Zeigt die Uhrzeit sofort an und wartet auf einen eventuellen zweiten Druck.
+// Bei einfachem Druck wird nach GLANCE_TICKS über GLANCE_FADE_TICKS ausgeblendet.
+// Rückgabe: 1 bei Doppeldruck (Anzeige bleibt an), 0 nach abgelaufenem Glance (LEDs aus).
+uint8_t wake_gesture(uint16_t wake_at) {
+    uint8_t released = 0;
+    uint16_t released_at = wake_at;
+    uint16_t elapsed;
+    uint16_t end = (GLANCE_TICKS + GLANCE_FADE_TICKS > DOUBLE_PRESS_TICKS)
+                   ? GLANCE_TICKS + GLANCE_FADE_TICKS : DOUBLE_PRESS_TICKS;
+
+    apply_brightness();
+    display_on = 1;
+    update_time_display();
+
+    while (1) {
+        elapsed = ticks_now() - wake_at;
+        if (elapsed >= end) {
+            break;
+        }
+
+        // Doppeldruck: Taste losgelassen und innerhalb des Fensters erneut gedrückt
+        if (!released) {
+            if (!any_button_pressed()) {
+                released = 1;
+                released_at = wake_at + elapsed;
+            }
+        } else if (elapsed <= DOUBLE_PRESS_TICKS && any_button_pressed() &&
+                   (uint16_t)(wake_at + elapsed - released_at) >= DEBOUNCE_TICKS) {
+            apply_brightness();
+            display_on = 1;
+            update_time_display();
+            return 1;
+        }
+
+        // Ausblenden; danach bleiben die LEDs aus, bis das Doppeldruck-Fenster abgelaufen ist.
+        if (elapsed >= GLANCE_TICKS + GLANCE_FADE_TICKS) {
+            if (display_on) {
+                last_wake_on_ticks = ticks_now() - wake_at;
+                display_off();
+            }
+        } else if (elapsed >= GLANCE_TICKS) {
+            set_pwm_minutes(fade_level(brightness_levels_minutes[brightness_index],
+                                       GLANCE_TICKS + GLANCE_FADE_TICKS - elapsed));
+            set_pwm_hours(fade_level(brightness_levels_hours[brightness_index],
+                                     GLANCE_TICKS + GLANCE_FADE_TICKS - elapsed));
+        }
+        _delay_ms(2);
+    }
+
+    if (display_on) {
+        last_wake_on_ticks = ticks_now() - wake_at;
+        display_off();
+    }
+    return 0;
+}
+
+// ----------------- Volle Anzeige -----------------
+// Manuelle Eingaben wie bisher; die Anzeige bleibt FULL_TIMEOUT_TICKS nach der letzten Eingabe an.
+void run_full_display(uint16_t wake_at) {
+    uint16_t deadline = ticks_now() + FULL_TIMEOUT_TICKS;
+
+    while (!tick_reached(deadline)) {
+        // Wenn PD0 UND PD1 gleichzeitig gedrückt werden, erfolgt die Helligkeitsanpassung.
+        if ( (!(PIND & (1 << BUTTON_BRIGHTNESS))) && (!(PIND & (1 << BUTTON_MINUTES))) ) {
+            brightness_index = (brightness_index + 1) % 5;
+            apply_brightness();
+            update_time_display();
+            deadline = ticks_now() + FULL_TIMEOUT_TICKS;  // Timeout zurücksetzen
+            _delay_ms(200);  // Entprellung
+        }
+        // Falls nur PD1 gedrückt wird (ohne PD0), erfolgt die Minutenanpassung.
+        else if ( (!(PIND & (1 << BUTTON_MINUTES))) && (PIND & (1 << BUTTON_BRIGHTNESS)) ) {
+            minutes = (minutes + 1) % 60;
+            update_time_display();
+            deadline = ticks_now() + FULL_TIMEOUT_TICKS;
+            _delay_ms(200);
+        }
+        // PD2 (Stundenanpassung) bleibt wie gehabt.
+        if (!(PIND & (1 << BUTTON_HOURS))) {
+            hours = (hours + 1) % 24;
+            update_time_display();
+            deadline = ticks_now() + FULL_TIMEOUT_TICKS;
+            _delay_ms(200);
+        }
+
+        _delay_ms(10);  // Kurze Pause zur Entlastung der CPU
+    }
+
+    last_wake_on_ticks = ticks_now() - wake_at;
+    display_off();
+}
+
 // ----------------- Hauptprogramm -----------------
 int main(void) {
+    uint16_t wake_at;
+
     init_io();
     init_pwm();
     init_timer2();
+    init_button_wakeup();
     disable_unused_peripherals();
     sei();  // Globale Interrupts aktivieren
 
-    // Setze initial die PWM-Werte gemäß brightness_index
-    set_pwm_minutes(brightness_levels_minutes[brightness_index]);
-    set_pwm_hours(brightness_levels_hours[brightness_index]);
+    // Nach dem Einschalten: volle Anzeige, damit die Uhrzeit gestellt werden kann.
+    apply_brightness();
+    display_on = 1;
     update_time_display();
-    display_timeout = 10;
+    wake_at = ticks_now();
 
     while (1) {
-        // Manuelle Eingaben werden nur ausgewertet, wenn die Anzeige aktiv ist.
-        if (display_timeout > 0) {
-            // Wenn PD0 UND PD1 gleichzeitig gedrückt werden, erfolgt die Helligkeitsanpassung.
-            if ( (!(PIND & (1 << BUTTON_BRIGHTNESS))) && (!(PIND & (1 << BUTTON_MINUTES))) ) {
-                brightness_index = (brightness_index + 1) % 5;
-                set_pwm_minutes(brightness_levels_minutes[brightness_index]);
-                set_pwm_hours(brightness_levels_hours[brightness_index]);
-                update_time_display();
-                display_timeout = 10;  // Timeout zurücksetzen
-                _delay_ms(200);  // Entprellung
-            }
-            // Falls nur PD1 gedrückt wird (ohne PD0), erfolgt die Minutenanpassung.
-            else if ( (!(PIND & (1 << BUTTON_MINUTES))) && (PIND & (1 << BUTTON_BRIGHTNESS)) ) {
-                minutes = (minutes + 1) % 60;
-                update_time_display();
-                display_timeout = 10;
-                _delay_ms(200);
-            }
-            // PD2 (Stundenanpassung) bleibt wie gehabt.
-            if (!(PIND & (1 << BUTTON_HOURS))) {
-                hours = (hours + 1) % 24;
-                update_time_display();
-                display_timeout = 10;
-                _delay_ms(200);
-            }
-        }
-        
-        // Falls kein Tastendruck erfolgt und der Timeout abgelaufen ist,
-        // wird in den Sleep-Mode gewechselt.
-        if (display_timeout == 0) {
+        run_full_display(wake_at);
+
+        // Schlafen, bis eine Taste gedrückt wird (Pin-Change weckt sofort, Timer2 jede Sekunde).
+        // Einfacher Druck: nur Glance, danach weiterschlafen. Doppeldruck: volle Anzeige.
+        while (1) {
             go_to_sleep();
-            // Nach dem Aufwachen: Warte, bis mindestens ein Button gedrückt wird.
-            while (1) {
-                if (!(PIND & (1 << BUTTON_BRIGHTNESS)) ||
-                    !(PIND & (1 << BUTTON_MINUTES)) ||
-                    !(PIND & (1 << BUTTON_HOURS))) {
-                    break;  // Eine Taste wurde gedrückt.
+            if (any_button_pressed()) {
+                wake_at = ticks_now();
+                if (wake_gesture(wake_at)) {
+                    break;
+                }
+                // Ein gehaltener Knopf startet keinen neuen Glance: erst Loslassen abwarten.
+                while (any_button_pressed()) {
+                    _delay_ms(10);
                 }
-                _delay_ms(10);
+                _delay_ms(20);  // Entprellung
             }
-            update_time_display();
-            display_timeout = 10;
         }
-        
-        _delay_ms(10);  // Kurze Pause zur Entlastung der CPU
+
+        // Der zweite Druck des Doppeldrucks soll nicht als Eingabe zählen.
+        while (any_button_pressed()) {
+            _delay_ms(10);
+        }
+        _delay_ms(20);  // Entprellung
     }
     
     return 0;